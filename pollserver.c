@@ -7,14 +7,98 @@
 #include <netdb.h>
 #include <poll.h>
 #include <time.h>
+#include <errno.h>
 
 #define PORT "8080"          // Port number used by server
 #define BUF_SIZE 1024        // Buffer size for send and receive
 #define BACKLOG 10           // Max pending connections
+#define MAX_SPIN_US 1000000  // Max busy-poll window (1 second) in microseconds
 
 // Global counter to track total messages echoed by server
 static int global_msg_count = 0;
 
+/*
+  Low-latency busy-poll mode (opt-in, for dedicated cores)
+  spin_window_us -> how long to spin on poll(..., 0) before blocking; 0 = off
+  spin_hits      -> poll rounds that delivered client data while spinning
+                    (listener accepts and disconnects alone do not count,
+                    matching server.c which only counts data reads)
+  parks          -> poll rounds where the spin window ran out and we blocked
+  The spin is done in user space only. SO_BUSY_POLL is deliberately not set
+  on client sockets: a blocking poll() would then busy-loop again for
+  net.core.busy_poll microseconds after the user-space spin, exceeding the
+  configured window.
+ */
+static long spin_window_us = 0;
+static long spin_hits = 0;
+static long parks = 0;
+
+/*
+  Monotonic timestamp in microseconds, used to time the spin window
+ */
+static long now_us(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1000000L + ts.tv_nsec / 1000;
+}
+
+/*
+  Parse the spin window given on the command line
+  Rejects non-numeric, partly numeric ("50us") or negative input and
+  clamps values above MAX_SPIN_US
+ */
+static long parse_spin_window(const char *arg, const char *prog)
+{
+    char *end;
+
+    errno = 0;
+    long usec = strtol(arg, &end, 10);
+
+    if (end == arg || *end != '\0' || errno == ERANGE || usec < 0) {
+        fprintf(stderr, "usage: %s [spin_us]  (0..%d microseconds)\n",
+                prog, MAX_SPIN_US);
+        exit(1);
+    }
+
+    if (usec > MAX_SPIN_US) {
+        fprintf(stderr, "spin window %ld us too large, using %d us\n",
+                usec, MAX_SPIN_US);
+        usec = MAX_SPIN_US;
+    }
+
+    return usec;
+}
+
+/*
+  poll() with an optional spin phase:
+  - busy-poll mode off -> plain blocking poll
+  - busy-poll mode on  -> poll with zero timeout until events arrive or
+                          spin_window_us expires, then block
+  *spun is set to 1 when the events arrived during the spin phase
+ */
+static int poll_spin_then_block(struct pollfd *pfds, int fd_count, int *spun)
+{
+    *spun = 0;
+
+    if (spin_window_us > 0) {
+        long deadline = now_us() + spin_window_us;
+
+        do {
+            int n = poll(pfds, fd_count, 0);
+            if (n != 0) {
+                if (n > 0) *spun = 1;
+                return n;
+            }
+        } while (now_us() < deadline);
+
+        // Spin budget exhausted, fall back to blocking
+        parks++;
+    }
+
+    return poll(pfds, fd_count, -1);
+}
+
 /*
   Create, bind, and return a listening socket
   Supports both IPv4 and IPv6 using a dual-stack IPv6 socket
@@ -133,8 +217,9 @@ void del_from_pfds(struct pollfd pfds[], int i, int *fd_count)
   - echo message
   - add server time
   - add global message count
+  Returns 1 if a message was echoed, 0 if the client went away
  */
-void handle_client_data(struct pollfd *pfds, int *fd_count, int *i)
+int handle_client_data(struct pollfd *pfds, int *fd_count, int *i)
 {
     char buf[BUF_SIZE];
     char reply[BUF_SIZE * 2];
@@ -150,10 +235,15 @@ void handle_client_data(struct pollfd *pfds, int *fd_count, int *i)
 
     // Client disconnected or error
     if (nbytes <= 0) {
+        // Report whether the spin budget is paying off
+        if (spin_window_us > 0)
+            printf("Client fd=%d closed (server total: spin hits %ld, parks %ld)\n",
+                   pfds[*i].fd, spin_hits, parks);
+
         close(pfds[*i].fd);
         del_from_pfds(pfds, *i, fd_count);
         (*i)--;   // adjust index after removal
-        return;
+        return 0;
     }
 
     // Null terminate received data
@@ -179,14 +269,23 @@ void handle_client_data(struct pollfd *pfds, int *fd_count, int *i)
 
     // Send response back to client
     send(pfds[*i].fd, reply, strlen(reply), 0);
+    return 1;
 }
 
-int main(void)
+/*
+  Usage: ./pollserver [spin_us]
+  spin_us -> optional busy-poll window in microseconds (default 0 = off,
+             values above MAX_SPIN_US are clamped)
+ */
+int main(int argc, char *argv[])
 {
     int listener;
     int fd_count = 0;     // number of active file descriptors
     int fd_size = 5;      // initial size of poll array
 
+    // Read optional busy-poll window
+    if (argc > 1) spin_window_us = parse_spin_window(argv[1], argv[0]);
+
     // Allocate pollfd array
     struct pollfd *pfds = malloc(sizeof *pfds * fd_size);
 
@@ -203,16 +302,22 @@ int main(void)
     fd_count = 1;
 
     printf("Poll echo server running on port %s\n", PORT);
+    if (spin_window_us > 0)
+        printf("Busy-poll mode: spinning up to %ld us before blocking\n",
+               spin_window_us);
 
     while (1) {
 
         /*
-           poll():
+           poll_spin_then_block():
            pfds     -> list of file descriptors
            fd_count -> number of fds
-           -1       -> wait indefinitely
+           spun     -> set if events arrived while spinning
+           Spins first in busy-poll mode, then waits indefinitely
         */
-        poll(pfds, fd_count, -1);
+        int spun;
+        int got_data = 0;
+        poll_spin_then_block(pfds, fd_count, &spun);
 
         // Loop through active file descriptors
         for (int i = 0; i < fd_count; i++) {
@@ -227,13 +332,16 @@ int main(void)
                     printf("New client connected (fd=%d)\n", newfd);
                 } else {
                     // Handle data from existing client
-                    handle_client_data(pfds, &fd_count, &i);
+                    got_data |= handle_client_data(pfds, &fd_count, &i);
                 }
 
                 // Clear event flags
                 pfds[i].revents = 0;
             }
         }
+
+        // Only rounds that delivered client data count as spin hits
+        if (spun && got_data) spin_hits++;
     }
 
     // Cleanup (normally not reached)
@@ -1,3 +1,4 @@
+#define _GNU_SOURCE     // Exposes RUSAGE_THREAD for per-thread context-switch counts
 #include <stdio.h>      // Provides standard IO functions like printf(), scanf()
 #include <stdlib.h>     // Contains functions such as malloc(), free(), atoi()
 #include <string.h>     // Used for string handling functions like strcpy(), strcmp(), strlen(),
@@ -6,7 +7,9 @@
 #include <sys/types.h>  // Defines data types used in system calls
 #include <sys/socket.h> // Provides socket programming functions like socket(), bind(), listen(), accept(), send(), recv()
 #include <netdb.h>      // Used for network database operations such as getaddrinfo()
-#include <time.h>       // Provides date and time functions like time(), localtime()
+#include <time.h>       // Provides date and time functions like time(), localtime(), clock_gettime()
+#include <errno.h>      // Provides errno values such as EAGAIN / EWOULDBLOCK
+#include <sys/resource.h> // Provides getrusage() to detect whether a recv() slept
 
 
 // Port number used by getaddrinfo for server/client communication 
@@ -15,6 +18,9 @@
 #define BUFFER_SIZE 1024
 // Number of successfull connections waiting in the queue to get accept by server limit
 #define BACKLOG 10 
+// Upper bound for the busy-poll window in microseconds (1 second); keeps the
+// value well inside SO_BUSY_POLL's int range and the deadline arithmetic safe
+#define MAX_SPIN_US 1000000
 
 /* Global counter to track total number of messages handled by the server */
 int message_count = 0;
@@ -22,6 +28,177 @@ int message_count = 0;
 /* Mutex used to protect the shared message counter from race conditions */
 pthread_mutex_t count_mutex = PTHREAD_MUTEX_INITIALIZER;
 
+/*
+   Low-latency busy-poll mode (opt-in, for dedicated cores).
+   spin_window_us - how long a client thread busy-polls for data before
+                    sleeping in a blocking recv(); 0 disables the mode
+   spin_hits      - messages that arrived within the spin window
+   parks          - receives that slept in the kernel, either because the
+                    spin window ran out or because no spin slot was free
+   Only receives that return data are counted; EOF and errors are not.
+   max_spinners   - cap on client threads allowed to spin at once, so idle
+                    connections cannot take over every core
+   spinners       - client threads currently holding a spin slot
+   The counters are protected by count_mutex, like message_count.
+*/
+long spin_window_us = 0;
+long spin_hits = 0;
+long parks = 0;
+long max_spinners = 0;
+long spinners = 0;
+
+// Returns a monotonic timestamp in microseconds, used to time the spin window
+static long now_us(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1000000L + ts.tv_nsec / 1000;
+}
+
+/*
+   Parse the spin window given on the command line.
+   Rejects anything that is not a plain non-negative number of microseconds
+   (e.g. "abc", "50us", "-5") and clamps values above MAX_SPIN_US.
+*/
+static long parse_spin_window(const char *arg, const char *prog)
+{
+    char *end;
+
+    errno = 0;
+    long usec = strtol(arg, &end, 10);
+
+    if (end == arg || *end != '\0' || errno == ERANGE || usec < 0) {
+        fprintf(stderr, "usage: %s [spin_us]  (0..%d microseconds)\n",
+                prog, MAX_SPIN_US);
+        exit(1);
+    }
+
+    if (usec > MAX_SPIN_US) {
+        fprintf(stderr, "spin window %ld us too large, using %d us\n",
+                usec, MAX_SPIN_US);
+        usec = MAX_SPIN_US;
+    }
+
+    return usec;
+}
+
+/*
+   Ask the kernel to busy-poll the device queue for this socket for up to
+   spin_window_us inside a blocking recv() before sleeping.
+   Returns 1 if SO_BUSY_POLL was accepted, 0 otherwise (option missing, or
+   CAP_NET_ADMIN needed to go above net.core.busy_read). Acceptance alone does
+   not mean the kernel will spin; see has_napi_id(). SO_PREFER_BUSY_POLL
+   is only a hint, so its result is ignored.
+*/
+static int enable_busy_poll(int fd)
+{
+    int accepted = 0;
+
+#ifdef SO_BUSY_POLL
+    int usec = (int)spin_window_us;
+    if (setsockopt(fd, SOL_SOCKET, SO_BUSY_POLL, &usec, sizeof(usec)) == 0)
+        accepted = 1;
+#endif
+#ifdef SO_PREFER_BUSY_POLL
+    int yes = 1;
+    setsockopt(fd, SOL_SOCKET, SO_PREFER_BUSY_POLL, &yes, sizeof(yes));
+#endif
+    (void)fd;
+    return accepted;
+}
+
+/*
+   The kernel only busy-polls sockets whose traffic came in on a NIC queue
+   with a NAPI id (loopback and many virtual NICs have none), so check it
+   before relying on SO_BUSY_POLL. The id is set by incoming packets, so
+   call this after the first message has arrived.
+*/
+static int has_napi_id(int fd)
+{
+#if defined(SO_INCOMING_NAPI_ID) && defined(RUSAGE_THREAD)
+    unsigned int napi_id = 0;
+    socklen_t optlen = sizeof(napi_id);
+
+    if (getsockopt(fd, SOL_SOCKET, SO_INCOMING_NAPI_ID,
+                   &napi_id, &optlen) == 0 && napi_id != 0)
+        return 1;
+#endif
+    (void)fd;
+    return 0;
+}
+
+// Voluntary context switches of the calling thread; goes up when it sleeps
+static long thread_vcsw(void)
+{
+#ifdef RUSAGE_THREAD
+    struct rusage ru;
+    if (getrusage(RUSAGE_THREAD, &ru) == 0)
+        return ru.ru_nvcsw;
+#endif
+    return 0;
+}
+
+/*
+   recv() wrapper used by the client threads. Only one of the two spin
+   strategies is used per connection, so a thread never spins for more
+   than spin_window_us per receive:
+   - kernel_busy set   -> the kernel spins inside a blocking recv() and then
+                          sleeps; a receive during which the thread made no
+                          voluntary context switch counts as a spin hit,
+                          one that slept counts as a park
+   - kernel_busy unset -> spin in user space on recv(MSG_DONTWAIT) for up to
+                          the window, then park in a plain blocking recv()
+   Threads without a spin slot (may_spin unset) always park.
+   *spun / *parked count how this connection's messages were received.
+*/
+static int recv_spin_then_block(int fd, char *buf, size_t len, int may_spin,
+                                int kernel_busy, long *spun, long *parked)
+{
+    if (spin_window_us > 0 && !may_spin) {
+        // Busy-poll mode is on but all spin slots are taken
+        int bytes = recv(fd, buf, len, 0);
+        if (bytes > 0)
+            (*parked)++;
+        return bytes;
+    }
+
+    if (spin_window_us > 0 && kernel_busy) {
+        long before = thread_vcsw();
+        int bytes = recv(fd, buf, len, 0);
+
+        if (bytes > 0) {
+            if (thread_vcsw() == before)
+                (*spun)++;
+            else
+                (*parked)++;
+        }
+        return bytes;
+    }
+
+    if (spin_window_us > 0) {
+        long deadline = now_us() + spin_window_us;
+
+        do {
+            int bytes = recv(fd, buf, len, MSG_DONTWAIT);
+
+            // Data (or EOF / real error) arrived while spinning
+            if (bytes >= 0 || (errno != EAGAIN && errno != EWOULDBLOCK)) {
+                if (bytes > 0)
+                    (*spun)++;
+                return bytes;
+            }
+        } while (now_us() < deadline);
+
+        // Spin budget exhausted, fall back to blocking
+        int bytes = recv(fd, buf, len, 0);
+        if (bytes > 0)
+            (*parked)++;
+        return bytes;
+    }
+
+    return recv(fd, buf, len, 0);
+}
+
 //This function is used to setup the socket information of the server to connect with clients 
 int setup_server_socket(void)
 {
@@ -146,16 +323,48 @@ void *handle_client(void *arg)
     // Buffer to store messages received from the client
     char buffer[BUFFER_SIZE];
 
+    // Per-connection busy-poll counters, folded into the globals on exit
+    long my_spins = 0, my_parks = 0;
+
+    // Set when SO_BUSY_POLL was accepted for this socket
+    int busy_hint = 0;
+
+    // Set when the kernel, rather than this thread, does the spinning
+    int kernel_busy = 0;
+
+    // Set when this thread holds one of the max_spinners spin slots
+    int may_spin = 0;
+
+    if (spin_window_us > 0) {
+        pthread_mutex_lock(&count_mutex);
+        if (spinners < max_spinners) {
+            spinners++;
+            may_spin = 1;
+        }
+        pthread_mutex_unlock(&count_mutex);
+
+        if (may_spin)
+            busy_hint = enable_busy_poll(client_fd);
+        else
+            printf("Client fd=%d: all %ld spin slots busy, blocking only\n",
+                   client_fd, max_spinners);
+    }
+
     while (1) {
 
         /*
-           recv():
+           recv_spin_then_block():
            client_fd        - socket descriptor for the connected client
            buffer           - buffer to store received data
            BUFFER_SIZE - 1  - maximum number of bytes to receive
-           flags (0)        - no special options
+           may_spin         - this thread holds a spin slot
+           kernel_busy      - kernel busy-poll is active on this socket
+           my_spins/my_parks- busy-poll counters for this connection
+           Behaves like a plain blocking recv() when busy-poll mode is off.
         */
-        int bytes = recv(client_fd, buffer, BUFFER_SIZE - 1, 0);
+        int bytes = recv_spin_then_block(client_fd, buffer, BUFFER_SIZE - 1,
+                                         may_spin, kernel_busy,
+                                         &my_spins, &my_parks);
 
         // If client closes the connection or an error occurs
         if (bytes <= 0)
@@ -164,6 +373,16 @@ void *handle_client(void *arg)
         // Null-terminate the received data
         buffer[bytes] = '\0';
 
+        /*
+           Hand the spinning over to the kernel only once the first message
+           shows the socket has a NAPI id; until then (and for good on
+           loopback / virtual NICs) keep the user-space spin.
+        */
+        if (busy_hint && !kernel_busy) {
+            kernel_busy = has_napi_id(client_fd);
+            busy_hint = 0;   // check once per connection
+        }
+
         // Get current server time
         time_t now = time(NULL);
         char *timestamp = ctime(&now);
@@ -204,6 +423,21 @@ void *handle_client(void *arg)
         send(client_fd, response, strlen(response), 0);
     }
 
+    // Report whether the spin budget paid off for this connection
+    if (spin_window_us > 0) {
+        pthread_mutex_lock(&count_mutex);
+        spin_hits += my_spins;
+        parks += my_parks;
+        if (may_spin)
+            spinners--;
+        long total_spins = spin_hits, total_parks = parks;
+        pthread_mutex_unlock(&count_mutex);
+
+        printf("Client fd=%d closed: spin hits %ld, parks %ld "
+               "(server total: spin hits %ld, parks %ld)\n",
+               client_fd, my_spins, my_parks, total_spins, total_parks);
+    }
+
     // Close client socket when communication ends
     close(client_fd);
 
@@ -212,11 +446,43 @@ void *handle_client(void *arg)
 }
 
 
-int main()
+/*
+   Usage: ./server [spin_us]
+   spin_us - optional busy-poll window in microseconds (0..MAX_SPIN_US;
+             larger values are clamped). When > 0 each client
+             thread spins for up to spin_us before blocking in recv(),
+             trading CPU for lower wakeup latency. Default 0 (off).
+             The spin happens in the kernel (SO_BUSY_POLL) when the process
+             is allowed to set it and the socket has a NAPI id, otherwise
+             in user space.
+             Each spinning connection keeps its own thread busy for the whole
+             window after every message, so CPU cost grows with the number
+             of connections. At most (online CPUs - 1) connections spin at
+             once; the rest block normally and their receives count as
+             parks. On a single-CPU host busy-poll mode is turned off.
+*/
+int main(int argc, char *argv[])
 {
+    if (argc > 1)
+        spin_window_us = parse_spin_window(argv[1], argv[0]);
+
+    // Leave one core for the accept loop and everything else
+    long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+    max_spinners = cpus > 1 ? cpus - 1 : 0;
+
+    // No core to spare: spinning would starve the accept loop
+    if (spin_window_us > 0 && max_spinners == 0) {
+        fprintf(stderr, "busy-poll unavailable: only one CPU online, "
+                "running in blocking mode\n");
+        spin_window_us = 0;
+    }
+
     // Create, bind, and start listening on the server socket
     int server_fd = setup_server_socket();
     printf("Server listening on port %s\n", PORT);
+    if (spin_window_us > 0)
+        printf("Busy-poll mode: spinning up to %ld us before blocking "
+               "(max %ld spinning clients)\n", spin_window_us, max_spinners);
 
     while (1) {
 